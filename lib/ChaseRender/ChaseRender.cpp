@@ -0,0 +1,39 @@
+#include "ChaseRender.h"
+
+void renderChaseGeneric(uint8_t* pixels, uint16_t count, uint8_t order, uint16_t head,
+                        uint16_t active, uint32_t fullColor, uint32_t dimmedColor) {
+  uint8_t wOffset = (order >> 6) & 3;
+  uint8_t rOffset = (order >> 4) & 3;
+  uint8_t gOffset = (order >> 2) & 3;
+  uint8_t bOffset = order & 3;
+  uint8_t bytesPerPixel = wOffset == rOffset ? 3 : 4;
+
+  for (uint16_t i = 0; i < count; i++) {
+    uint16_t distance = (i + count - head) % count;
+    uint32_t color = distance < active ? fullColor : dimmedColor;
+    uint8_t* p = pixels + i * bytesPerPixel;
+    if (bytesPerPixel == 4) p[wOffset] = 0;
+    p[rOffset] = color >> 16;
+    p[gOffset] = color >> 8;
+    p[bOffset] = color;
+  }
+}
+
+template <uint8_t R, uint8_t G, uint8_t B, uint8_t BPP>
+static RenderKernel kernelForLength(uint16_t count) {
+  switch (count) {
+    case 16: return renderChase<R, G, B, BPP, 16>;
+    case 60: return renderChase<R, G, B, BPP, 60>;
+    case 144: return renderChase<R, G, B, BPP, 144>;
+    default: return renderChase<R, G, B, BPP, 0>;
+  }
+}
+
+RenderKernel selectRenderKernel(uint8_t order, uint16_t count) {
+  switch (order) {
+    case CHASE_ORDER_GRB: return kernelForLength<1, 0, 2, 3>(count);
+    case CHASE_ORDER_RGB: return kernelForLength<0, 1, 2, 3>(count);
+    case CHASE_ORDER_GRBW: return kernelForLength<1, 0, 2, 4>(count);
+    default: return renderChaseGeneric;
+  }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+// Render kernels for the status chase. They write straight into a NeoPixel
+// pixel buffer: a dimmed background with `active` full-color pixels starting
+// at `head`, wrapping at the end of the strip.
+//
+// Color orders use the Adafruit_NeoPixel encoding (2-bit W, R, G, B byte
+// offsets), so NEO_GRB etc. can be passed directly.
+#define CHASE_ORDER(w, r, g, b) (((w) << 6) | ((r) << 4) | ((g) << 2) | (b))
+#define CHASE_ORDER_RGB CHASE_ORDER(0, 0, 1, 2)
+#define CHASE_ORDER_GRB CHASE_ORDER(1, 1, 0, 2)
+#define CHASE_ORDER_GRBW CHASE_ORDER(3, 1, 0, 2)
+
+typedef void (*RenderKernel)(uint8_t* pixels, uint16_t count, uint8_t order, uint16_t head,
+                             uint16_t active, uint32_t fullColor, uint32_t dimmedColor);
+
+// Byte offsets and, for common strip lengths, the length are template
+// parameters, so the per-pixel loop carries no color-order or length lookups
+template <uint8_t R, uint8_t G, uint8_t B, uint8_t BPP, uint16_t N>
+void renderChase(uint8_t* pixels, uint16_t count, uint8_t, uint16_t head, uint16_t active,
+                 uint32_t fullColor, uint32_t dimmedColor) {
+  const uint16_t n = N ? N : count;
+  uint8_t full[BPP] = {0};  // White channel, if any, stays off
+  uint8_t dimmed[BPP] = {0};
+  full[R] = fullColor >> 16;
+  full[G] = fullColor >> 8;
+  full[B] = fullColor;
+  dimmed[R] = dimmedColor >> 16;
+  dimmed[G] = dimmedColor >> 8;
+  dimmed[B] = dimmedColor;
+
+  for (uint16_t i = 0; i < n; i++) {
+    memcpy(pixels + i * BPP, dimmed, BPP);
+  }
+
+  uint16_t lit = head;
+  for (uint16_t k = 0; k < active; k++) {
+    memcpy(pixels + lit * BPP, full, BPP);
+    if (++lit == n) lit = 0;
+  }
+}
+
+// Any color order, resolved per pixel at run time
+void renderChaseGeneric(uint8_t* pixels, uint16_t count, uint8_t order, uint16_t head,
+                        uint16_t active, uint32_t fullColor, uint32_t dimmedColor);
+
+// Pick the fastest kernel for a color order and strip length
+RenderKernel selectRenderKernel(uint8_t order, uint16_t count);
@@ -0,0 +1,373 @@
+#include "InflateStream.h"
+
+// ===== Deflate Tables (RFC 1951) =====
+static const uint16_t LENGTH_BASE[29] = {
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t LENGTH_EXTRA[29] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t DISTANCE_BASE[30] = {
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+  257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t DISTANCE_EXTRA[30] = {
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+  7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+static const uint8_t CODE_LENGTH_ORDER[19] = {
+  16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+#define GZIP_FHCRC 0x02
+#define GZIP_FEXTRA 0x04
+#define GZIP_FNAME 0x08
+#define GZIP_FCOMMENT 0x10
+
+// ===== Public Interface =====
+InflateStream& InflateStream::begin(Stream& src) {
+  source = &src;
+  state = STATE_HEADER;
+  finalBlock = false;
+  storedRemaining = 0;
+  bitBuffer = 0;
+  bitCount = 0;
+  bytesIn = 0;
+  outPos = 0;
+  readPos = 0;
+  return *this;
+}
+
+int InflateStream::available() {
+  if (outPos != readPos) return outPos - readPos;
+  if (state == STATE_DONE || state == STATE_ERROR) return 0;
+  return source->available() > 0 ? 1 : 0;
+}
+
+int InflateStream::read() {
+  if (!fill()) return -1;
+  return window[readPos++ & (WINDOW_SIZE - 1)];
+}
+
+int InflateStream::peek() {
+  if (!fill()) return -1;
+  return window[readPos & (WINDOW_SIZE - 1)];
+}
+
+// ===== Decoder State Machine =====
+// Decode until at least one unread byte is in the window. A single symbol
+// produces at most 258 bytes, so unread output never wraps onto itself.
+bool InflateStream::fill() {
+  while (readPos == outPos) {
+    switch (state) {
+      case STATE_HEADER:
+        if (readGzipHeader()) state = STATE_BLOCK_START;
+        break;
+      case STATE_BLOCK_START:
+        startBlock();
+        break;
+      case STATE_STORED:
+        if (storedRemaining == 0) {
+          endBlock();
+        } else {
+          int value = readByte();
+          if (value >= 0) {
+            emit(value);
+            storedRemaining--;
+          }
+        }
+        break;
+      case STATE_HUFFMAN:
+        decodeSymbol();
+        break;
+      case STATE_DONE:
+      case STATE_ERROR:
+        return false;
+    }
+  }
+  return true;
+}
+
+bool InflateStream::readGzipHeader() {
+  if (readByte() != 0x1f || readByte() != 0x8b || readByte() != 8) {
+    fail("not a gzip stream");
+    return false;
+  }
+
+  int flags = readByte();
+  for (int i = 0; i < 6; i++) readByte();  // MTIME, XFL, OS
+
+  if (flags & GZIP_FEXTRA) {
+    int extraLength = readUint16();
+    for (int i = 0; i < extraLength && !failed(); i++) readByte();
+  }
+  if (flags & GZIP_FNAME) {
+    while (readByte() > 0);
+  }
+  if (flags & GZIP_FCOMMENT) {
+    while (readByte() > 0);
+  }
+  if (flags & GZIP_FHCRC) {
+    readByte();
+    readByte();
+  }
+
+  return !failed();
+}
+
+bool InflateStream::startBlock() {
+  finalBlock = getBit();
+  int type = getBits(2);
+  if (failed()) return false;
+
+  if (type == 0) {
+    // Stored block: skip to the byte boundary, then LEN and its complement
+    bitCount = 0;
+    uint16_t length = readUint16();
+    uint16_t inverse = readUint16();
+    if (failed()) return false;
+    if (length != (uint16_t)~inverse) {
+      fail("corrupt stored block length");
+      return false;
+    }
+    storedRemaining = length;
+    state = STATE_STORED;
+  } else if (type == 1) {
+    for (int i = 0; i < 144; i++) lengths[i] = 8;
+    for (int i = 144; i < 256; i++) lengths[i] = 9;
+    for (int i = 256; i < 280; i++) lengths[i] = 7;
+    for (int i = 280; i < 288; i++) lengths[i] = 8;
+    buildTree(literalTree, lengths, 288);
+    for (int i = 0; i < 30; i++) lengths[i] = 5;
+    buildTree(distanceTree, lengths, 30);
+    state = STATE_HUFFMAN;
+  } else if (type == 2) {
+    if (!decodeTrees()) return false;
+    state = STATE_HUFFMAN;
+  } else {
+    fail("invalid block type");
+    return false;
+  }
+  return true;
+}
+
+void InflateStream::endBlock() {
+  if (!finalBlock) {
+    state = STATE_BLOCK_START;
+  } else if (readTrailer()) {
+    state = STATE_DONE;
+  }
+}
+
+bool InflateStream::decodeSymbol() {
+  int symbol = decode(literalTree);
+  if (symbol < 0) return false;
+
+  if (symbol < 256) {
+    emit(symbol);
+    return true;
+  }
+  if (symbol == 256) {
+    endBlock();
+    return !failed();
+  }
+
+  symbol -= 257;
+  if (symbol >= 29) {
+    fail("invalid length symbol");
+    return false;
+  }
+  int length = LENGTH_BASE[symbol] + getBits(LENGTH_EXTRA[symbol]);
+
+  int distanceSymbol = decode(distanceTree);
+  if (distanceSymbol < 0) return false;
+  if (distanceSymbol >= 30) {
+    fail("invalid distance symbol");
+    return false;
+  }
+  uint32_t distance = DISTANCE_BASE[distanceSymbol] + getBits(DISTANCE_EXTRA[distanceSymbol]);
+  if (failed()) return false;
+  if (distance > outPos) {
+    fail("distance before start of output");
+    return false;
+  }
+
+  // Byte by byte so overlapping copies (distance < length) repeat correctly
+  for (int i = 0; i < length; i++) {
+    emit(window[(outPos - distance) & (WINDOW_SIZE - 1)]);
+  }
+  return true;
+}
+
+// CRC32 is not checked - TLS already guarantees integrity - but the size
+// is, and reading the trailer leaves the connection at the end of the body
+bool InflateStream::readTrailer() {
+  bitCount = 0;
+  uint32_t trailer[2] = {0, 0};
+  for (int i = 0; i < 8; i++) {
+    trailer[i / 4] |= (uint32_t)readByte() << (8 * (i % 4));
+  }
+  if (failed()) return false;
+  if (trailer[1] != outPos) {
+    fail("inflated size mismatch");
+    return false;
+  }
+  return true;
+}
+
+// ===== Huffman Trees =====
+bool InflateStream::decodeTrees() {
+  int literalCount = getBits(5) + 257;
+  int distanceCount = getBits(5) + 1;
+  int codeLengthCount = getBits(4) + 4;
+
+  memset(lengths, 0, 19);
+  for (int i = 0; i < codeLengthCount; i++) {
+    lengths[CODE_LENGTH_ORDER[i]] = getBits(3);
+  }
+  if (failed()) return false;
+
+  // The distance tree doubles as the code length tree until it is rebuilt
+  buildTree(distanceTree, lengths, 19);
+
+  int total = literalCount + distanceCount;
+  int n = 0;
+  while (n < total) {
+    int symbol = decode(distanceTree);
+    if (symbol < 0) return false;
+
+    if (symbol < 16) {
+      lengths[n++] = symbol;
+      continue;
+    }
+
+    int repeat;
+    uint8_t value = 0;
+    if (symbol == 16) {
+      if (n == 0) {
+        fail("repeat with no previous length");
+        return false;
+      }
+      value = lengths[n - 1];
+      repeat = 3 + getBits(2);
+    } else if (symbol == 17) {
+      repeat = 3 + getBits(3);
+    } else {
+      repeat = 11 + getBits(7);
+    }
+
+    if (failed()) return false;
+    if (n + repeat > total) {
+      fail("code lengths overflow");
+      return false;
+    }
+    while (repeat--) lengths[n++] = value;
+  }
+
+  if (lengths[256] == 0) {
+    fail("missing end of block code");
+    return false;
+  }
+
+  buildTree(literalTree, lengths, literalCount);
+  buildTree(distanceTree, lengths + literalCount, distanceCount);
+  return true;
+}
+
+void InflateStream::buildTree(Tree& tree, const uint8_t* codeLengths, int count) {
+  uint16_t offsets[16];
+
+  memset(tree.counts, 0, sizeof(tree.counts));
+  for (int i = 0; i < count; i++) {
+    tree.counts[codeLengths[i]]++;
+  }
+  tree.counts[0] = 0;
+
+  uint16_t sum = 0;
+  for (int i = 0; i < 16; i++) {
+    offsets[i] = sum;
+    sum += tree.counts[i];
+  }
+
+  for (int i = 0; i < count; i++) {
+    if (codeLengths[i]) {
+      tree.symbols[offsets[codeLengths[i]]++] = i;
+    }
+  }
+}
+
+// Canonical Huffman decode: walk the code one bit at a time against the
+// number of codes at each length
+int InflateStream::decode(const Tree& tree) {
+  int sum = 0;
+  int code = 0;
+  int length = 0;
+
+  do {
+    code = 2 * code + getBit();
+    if (failed()) return -1;
+    if (++length > 15) {
+      fail("invalid Huffman code");
+      return -1;
+    }
+    sum += tree.counts[length];
+    code -= tree.counts[length];
+  } while (code >= 0);
+
+  return tree.symbols[sum + code];
+}
+
+// ===== Bit Input =====
+int InflateStream::readByte() {
+  if (state == STATE_ERROR) return -1;
+
+  uint8_t value;
+  if (source->readBytes(&value, 1) != 1) {
+    fail("timed out reading compressed body");
+    return -1;
+  }
+  bytesIn++;
+  return value;
+}
+
+// Little-endian; the two reads must stay separate statements to keep their order
+uint16_t InflateStream::readUint16() {
+  int low = readByte();
+  int high = readByte();
+  return (uint16_t)(low | (high << 8));
+}
+
+int InflateStream::getBit() {
+  if (bitCount == 0) {
+    int value = readByte();
+    if (value < 0) return 0;
+    bitBuffer = value;
+    bitCount = 8;
+  }
+  int bit = bitBuffer & 1;
+  bitBuffer >>= 1;
+  bitCount--;
+  return bit;
+}
+
+int InflateStream::getBits(int count) {
+  int value = 0;
+  for (int i = 0; i < count; i++) {
+    value |= getBit() << i;
+  }
+  return value;
+}
+
+void InflateStream::emit(uint8_t value) {
+  window[outPos++ & (WINDOW_SIZE - 1)] = value;
+}
+
+void InflateStream::fail(const char* reason) {
+  if (state != STATE_ERROR) {
+    Serial.print("Inflate error: ");
+    Serial.println(reason);
+  }
+  state = STATE_ERROR;
+}
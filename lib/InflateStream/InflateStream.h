@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Streaming gzip decoder. Wraps a Stream carrying a gzip body and yields the
+// inflated bytes one at a time, so a JSON parser can read it directly without
+// the compressed or inflated body ever being buffered in full.
+//
+// The only large buffer is the 32 KB history window that deflate
+// back-references require; symbols are decoded on demand as bytes are read.
+class InflateStream : public Stream {
+public:
+  static const uint32_t WINDOW_SIZE = 32768;
+
+  // Start decoding a new gzip member read from source
+  InflateStream& begin(Stream& source);
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t) override { return 0; }
+
+  bool finished() const { return state == STATE_DONE; }
+  bool failed() const { return state == STATE_ERROR; }
+  uint32_t compressedBytes() const { return bytesIn; }
+  uint32_t inflatedBytes() const { return outPos; }
+
+private:
+  enum State {
+    STATE_HEADER,
+    STATE_BLOCK_START,
+    STATE_STORED,
+    STATE_HUFFMAN,
+    STATE_DONE,
+    STATE_ERROR
+  };
+
+  struct Tree {
+    uint16_t counts[16];   // Number of codes of each bit length
+    uint16_t symbols[288]; // Symbols ordered by code
+  };
+
+  bool fill();
+  bool readGzipHeader();
+  bool startBlock();
+  void endBlock();
+  bool decodeSymbol();
+  bool readTrailer();
+  bool decodeTrees();
+  void buildTree(Tree& tree, const uint8_t* codeLengths, int count);
+  int decode(const Tree& tree);
+  int readByte();
+  uint16_t readUint16();
+  int getBit();
+  int getBits(int count);
+  void emit(uint8_t value);
+  void fail(const char* reason);
+
+  Stream* source = nullptr;
+  State state = STATE_ERROR;
+  bool finalBlock = false;
+  uint32_t storedRemaining = 0;
+  uint32_t bitBuffer = 0;
+  int bitCount = 0;
+  uint32_t bytesIn = 0;
+  uint32_t outPos = 0;    // Total bytes decoded
+  uint32_t readPos = 0;   // Total bytes handed to the reader
+  Tree literalTree;
+  Tree distanceTree;
+  uint8_t lengths[288 + 32];
+  uint8_t window[WINDOW_SIZE];
+};
@@ -0,0 +1,78 @@
+#include "MonitorList.h"
+#include <ArduinoJson.h>
+
+int statusSeverity(const char* status) {
+  if (!status) return -1;
+  if (strcasecmp(status, "alert") == 0) return 3;
+  if (strcasecmp(status, "warn") == 0) return 2;
+  if (strcasecmp(status, "no data") == 0) return 1;
+  return 0;
+}
+
+int peekJsonToken(Stream& body) {
+  unsigned long start = millis();
+  while (millis() - start < JSON_STREAM_TIMEOUT) {
+    int c = body.peek();
+    if (c < 0) {
+      delay(1);
+    } else if (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+      body.read();
+    } else {
+      return c;
+    }
+  }
+  return -1;
+}
+
+// Collapse per-status monitor counts (indexed by statusSeverity) into one
+// status. A lone "No Data" monitor does not change the color, but an org
+// where nothing reports data does.
+const char* summarizeStatusCounts(const int counts[4]) {
+  if (counts[3] > 0) return "alert";
+  if (counts[2] > 0) return "warn";
+  if (counts[1] > 0 && counts[0] == 0) return "no data";
+  return "ok";
+}
+
+void tallyStatus(int counts[4], const char* status, int count) {
+  int severity = statusSeverity(status);
+  if (severity > 0 || strcasecmp(status, "ok") == 0) {
+    counts[severity] += count;
+  }
+}
+
+const char* aggregateMonitorList(Stream& body) {
+  StaticJsonDocument<64> filter;
+  filter["name"] = true;
+  filter["overall_state"] = true;
+  
+  if (!body.find("[")) {
+    Serial.println("Monitor list not found in response");
+    return nullptr;
+  }
+  
+  int counts[4] = {0, 0, 0, 0};
+  if (peekJsonToken(body) == ']') {
+    return summarizeStatusCounts(counts);  // No monitors match
+  }
+  
+  StaticJsonDocument<256> monitor;
+  do {
+    DeserializationError error = deserializeJson(monitor, body, DeserializationOption::Filter(filter));
+    if (error) {
+      Serial.print("JSON parsing error: ");
+      Serial.println(error.c_str());
+      return nullptr;
+    }
+    
+    const char* monitorStatus = monitor["overall_state"] | "";
+    Serial.print("Monitor: ");
+    Serial.print(monitor["name"] | "");
+    Serial.print(" - Status: ");
+    Serial.println(monitorStatus);
+    tallyStatus(counts, monitorStatus, 1);
+  } while (body.findUntil(",", "]"));
+  
+  return summarizeStatusCounts(counts);
+}
+
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Monitor status helpers shared by the polling code in src/ and the host
+// benchmarks. Statuses are the lower-case names the LEDs understand:
+// "ok", "warn", "alert" and "no data".
+
+const unsigned long JSON_STREAM_TIMEOUT = 5000;
+
+// Rank a status so results from several monitors/orgs can be merged
+int statusSeverity(const char* status);
+
+// Blocking peek that skips JSON whitespace
+int peekJsonToken(Stream& body);
+
+// Per-status monitor counts are indexed by statusSeverity
+void tallyStatus(int counts[4], const char* status, int count);
+const char* summarizeStatusCounts(const int counts[4]);
+
+// Parse a /api/v1/monitor array one element at a time so memory stays
+// constant no matter how many monitors the org has. Returns nullptr if the
+// body is cut short or malformed.
+const char* aggregateMonitorList(Stream& body);
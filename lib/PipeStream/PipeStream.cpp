@@ -0,0 +1,103 @@
+#include "PipeStream.h"
+
+void PipeStream::reset() {
+  head.store(0, std::memory_order_relaxed);
+  tail.store(0, std::memory_order_relaxed);
+  closed.store(false, std::memory_order_relaxed);
+  done.store(false, std::memory_order_release);
+  readOffset = 0;
+}
+
+// ===== Producer =====
+uint8_t* PipeStream::acquireBlock() {
+  uint32_t published = head.load(std::memory_order_relaxed);
+  if (published - tail.load(std::memory_order_acquire) >= BLOCK_COUNT) {
+    return nullptr;
+  }
+  return blocks[published % BLOCK_COUNT].data;
+}
+
+void PipeStream::publishBlock(size_t length) {
+  uint32_t published = head.load(std::memory_order_relaxed);
+  blocks[published % BLOCK_COUNT].length = length;
+  head.store(published + 1, std::memory_order_release);
+}
+
+void PipeStream::close() {
+  closed.store(true, std::memory_order_release);
+}
+
+bool PipeStream::fillFrom(Stream& source, unsigned long timeout) {
+  bool timedOut = false;
+  unsigned long lastData = millis();
+  while (!consumerDone()) {
+    uint8_t* block = acquireBlock();
+    if (!block) {
+      yield();  // Ring full, spin until the consumer frees a block
+      continue;
+    }
+
+    // Publish whatever has arrived rather than waiting for a full block
+    size_t length = 0;
+    int c;
+    while (length < BLOCK_SIZE && (c = source.read()) >= 0) {
+      block[length++] = c;
+    }
+
+    if (length > 0) {
+      publishBlock(length);
+      lastData = millis();
+    } else if (millis() - lastData > timeout) {
+      timedOut = true;
+      break;
+    } else {
+      delay(1);
+    }
+  }
+
+  close();
+  return !timedOut;
+}
+
+// ===== Consumer =====
+bool PipeStream::waitForData() {
+  uint32_t consumed = tail.load(std::memory_order_relaxed);
+  while (consumed == head.load(std::memory_order_acquire)) {
+    if (closed.load(std::memory_order_acquire)) {
+      // A block may have been published just before the close
+      return consumed != head.load(std::memory_order_acquire);
+    }
+    if (idle) idle();
+  }
+  return true;
+}
+
+int PipeStream::available() {
+  uint32_t consumed = tail.load(std::memory_order_relaxed);
+  if (consumed == head.load(std::memory_order_acquire)) return 0;
+  return blocks[consumed % BLOCK_COUNT].length - readOffset;
+}
+
+int PipeStream::read() {
+  if (!waitForData()) return -1;
+
+  uint32_t consumed = tail.load(std::memory_order_relaxed);
+  const Block& block = blocks[consumed % BLOCK_COUNT];
+  uint8_t value = block.data[readOffset++];
+
+  if (readOffset >= block.length) {
+    readOffset = 0;
+    tail.store(consumed + 1, std::memory_order_release);
+    if (idle) idle();
+  }
+  return value;
+}
+
+int PipeStream::peek() {
+  if (!waitForData()) return -1;
+  return blocks[tail.load(std::memory_order_relaxed) % BLOCK_COUNT].data[readOffset];
+}
+
+void PipeStream::finish() {
+  done.store(true, std::memory_order_release);
+}
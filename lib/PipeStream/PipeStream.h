@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+// Single-producer/single-consumer pipe of fixed-size blocks for handing a
+// response body from one core to the other. The producer fills and publishes
+// blocks; the consumer reads them back as a Stream. Each index is written by
+// one side only, so no locks are taken. When the ring is full the producer
+// gets no block until the consumer frees one (backpressure).
+class PipeStream : public Stream {
+public:
+  static const size_t BLOCK_SIZE = 512;
+  static const uint32_t BLOCK_COUNT = 8;
+
+  // Start a new transfer - only while neither side is using the pipe
+  void reset();
+
+  // Producer side
+  uint8_t* acquireBlock();           // nullptr while the ring is full
+  void publishBlock(size_t length);  // Hand the acquired block to the consumer
+  void close();                      // No more blocks will follow
+  // Copy source into the pipe until the consumer finishes or source stays
+  // empty for timeout ms, then close. Returns false on timeout.
+  bool fillFrom(Stream& source, unsigned long timeout);
+  bool consumerDone() const { return done.load(std::memory_order_acquire); }
+
+  // Consumer side. Reads block until data arrives or the producer closes,
+  // calling the idle callback while waiting and after each block.
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t) override { return 0; }
+  void finish();                     // Stop consuming; the producer discards the rest
+  void onIdle(void (*callback)()) { idle = callback; }
+
+private:
+  struct Block {
+    uint16_t length;
+    uint8_t data[BLOCK_SIZE];
+  };
+
+  bool waitForData();
+
+  Block blocks[BLOCK_COUNT];
+  std::atomic<uint32_t> head{0};   // Blocks published, written by the producer
+  std::atomic<uint32_t> tail{0};   // Blocks consumed, written by the consumer
+  std::atomic<bool> closed{false};
+  std::atomic<bool> done{false};
+  size_t readOffset = 0;           // Position in the tail block, consumer only
+  void (*idle)() = nullptr;
+};
@@ -1,46 +1,69 @@
 #include <Arduino.h>
+#include <atomic>
 #include <WiFi.h>
 #include <ArduinoHttpClient.h>
 #include <ArduinoJson.h>
 #include <Adafruit_NeoPixel.h>
 #include <LittleFS.h>
 #include <WebServer.h>
-#include <hardware/watchdog.h>
+#include <InflateStream.h>
+#include <PipeStream.h>
+#include <ChaseRender.h>
+#include <MonitorList.h>
 
-// WiFi credentials - replaced by stored credentials
+// Datadog defaults - used for any field a query profile leaves out
 const char* DATADOG_API_KEY = "YOUR_DATADOG_API_KEY";
 const char* DATADOG_APP_KEY = "YOUR_DATADOG_APP_KEY";
 const char* DATADOG_HOST = "api.datadoghq.com";
 const int DATADOG_PORT = 443;
 
-// WS2812 LED Strip configuration
+// WS2812 LED Strip configuration - defaults, overridden by STRIP_CONFIG_FILE
 #define LED_PIN 8
 #define LED_COUNT 16
+#define MAX_LED_COUNT 300
 Adafruit_NeoPixel strip(LED_COUNT, LED_PIN, NEO_GRB + NEO_KHZ800);
 
+enum StripLayout {
+  LAYOUT_RING,  // Chase wraps around (ring or stack)
+  LAYOUT_BAR    // Chase bounces between the ends
+};
+
+StripLayout stripLayout = LAYOUT_RING;
+volatile bool stripReady = false;  // Core 1 must not render while the strip is being resized
+
 // File system constants
 #define CREDENTIALS_FILE "/credentials.json"
 #define AP_SSID "MoniTower-Setup"
 #define AP_PASSWORD "MoniTower123"
 #define BOOT_COUNT_FILE "/boot_count.json"
 #define MAX_BOOT_COUNT 3
+#define PROFILES_FILE "/profiles.json"
+#define STRIP_CONFIG_FILE "/strip.json"
+#define STATUS_LOG_FILE "/status.log"
+#define STATUS_LOG_MAX_RECORDS 64
 
 // Animation variables
 unsigned long lastAnimationTime = 0;
 int animationIndex = 0;
 const int ANIMATION_DELAY = 100;
 const int ACTIVE_LED_COUNT = 3;
+int activeLedCount = ACTIVE_LED_COUNT;
 const int DIM_BRIGHTNESS = 30;
 char currentStatus[20] = "no data";  // Track current status for animation updates
+volatile bool statusStale = false;   // Showing the status restored at boot, not a fresh poll
+const int STALE_ANIMATION_DELAY = 300;
 
 // WiFi and provisioning variables
 WiFiClientSecure wifiClient;
 HttpClient* httpClient = nullptr;
 WebServer server(80);
 bool inAPMode = false;
+bool webServerStarted = false;
 bool wifiConnectAttempted = false;
 unsigned long wifiConnectStartTime = 0;
+bool credentialsVerified = false;  // Stored credentials have joined the network this boot
 const unsigned long WIFI_CONNECT_TIMEOUT = 15000; // 15 seconds to connect
+const unsigned long PROVISION_HANDOFF_DELAY = 5000; // Time for the browser to read the result, where the AP survives the join
 
 // Structure to hold WiFi credentials
 struct Credentials {
@@ -50,12 +73,68 @@ struct Credentials {
 
 Credentials storedCredentials = {"", ""};
 
+// Provisioning test-join: new credentials are tried in AP+STA mode while the
+// portal stays up, and only saved once the network has accepted them
+enum ProvisionState {
+  PROVISION_IDLE,
+  PROVISION_TESTING,
+  PROVISION_CONNECTED,
+  PROVISION_FAILED
+};
+
+ProvisionState provisionState = PROVISION_IDLE;
+Credentials pendingCredentials = {"", ""};
+unsigned long provisionStartTime = 0;
+
+// Datadog query profiles - one per org/site/filter combination
+#define MAX_PROFILES 8
+#define MAX_POOLED_HOSTS 3
+const int MAX_POLLS_PER_CYCLE = 4;           // Requests per 30 second check, regardless of profile count
+const int MAX_FAILED_POLLS = 3;              // Consecutive failed polls before a profile shows "no data"
+
+struct QueryProfile {
+  char host[64];
+  char apiKey[48];
+  char appKey[48];
+  char filter[96];      // monitor_tags filter, e.g. "env:prod,team:web"
+  int weight;           // Share of poll slots when profiles outnumber MAX_POLLS_PER_CYCLE
+  int currentWeight;    // Smooth weighted round-robin state
+  bool countsMode;      // Fetch status counts only; off with "per_monitor": true, or after search returns 400/404
+  bool pipelined;       // Parse full listings on core 1 while core 0 receives (off until measured on device)
+  const char* status;   // Last result, nullptr until first polled
+  int failedPolls;      // Consecutive polls that got no result (request, HTTP or body error)
+};
+
+QueryProfile profiles[MAX_PROFILES];
+int profileCount = 0;
+
+// One persistent (keep-alive) TLS connection per Datadog host
+struct PooledConnection {
+  char host[64];
+  WiFiClientSecure client;
+  HttpClient* http;
+};
+
+PooledConnection connectionPool[MAX_POOLED_HOSTS];
+int pooledHostCount = 0;
+
+// Inflates gzip response bodies straight into the JSON parser (32 KB window, shared by all profiles)
+InflateStream gzipBody;
+
+// Pipelined parsing (per profile, "pipelined": true): core 0 receives the
+// monitor list into bodyPipe while core 1 parses it between animation frames
+PipeStream bodyPipe;
+std::atomic<bool> pipelineParseRequested{false};
+std::atomic<const char*> pipelineStatus{nullptr};
+
 // ===== Forward Declarations =====
 void handleRoot();
 void handleConfigure();
+void handleStatus();
 void handleNotFound();
 void startAccessPoint();
 void setLEDStatus(const char* status);
+void reportStatus(const char* status);
 void updateAnimation();
 
 // ===== File System Functions =====
@@ -132,6 +211,240 @@ bool deleteCredentials() {
   return false;
 }
 
+bool loadProfiles() {
+  if (!LittleFS.exists(PROFILES_FILE)) {
+    Serial.println("No query profiles file found");
+    return false;
+  }
+  
+  File file = LittleFS.open(PROFILES_FILE, "r");
+  if (!file) {
+    Serial.println("Failed to open query profiles file");
+    return false;
+  }
+  
+  StaticJsonDocument<2048> doc;
+  DeserializationError error = deserializeJson(doc, file);
+  file.close();
+  
+  if (error) {
+    Serial.print("Failed to parse query profiles: ");
+    Serial.println(error.c_str());
+    return false;
+  }
+  
+  profileCount = 0;
+  int hostCount = 0;
+  for (JsonObject entry : doc.as<JsonArray>()) {
+    if (profileCount >= MAX_PROFILES) {
+      Serial.println("Too many query profiles, ignoring the rest");
+      break;
+    }
+    
+    QueryProfile& profile = profiles[profileCount];
+    strlcpy(profile.host, entry["host"] | DATADOG_HOST, sizeof(profile.host));
+    strlcpy(profile.apiKey, entry["api_key"] | DATADOG_API_KEY, sizeof(profile.apiKey));
+    strlcpy(profile.appKey, entry["app_key"] | DATADOG_APP_KEY, sizeof(profile.appKey));
+    strlcpy(profile.filter, entry["filter"] | "", sizeof(profile.filter));
+    profile.weight = entry["weight"] | 1;
+    profile.currentWeight = 0;
+    profile.countsMode = !(entry["per_monitor"] | false);
+    profile.pipelined = entry["pipelined"] | false;
+    profile.status = nullptr;
+    profile.failedPolls = 0;
+    
+    if (profile.weight <= 0) {
+      Serial.print("Skipping disabled profile for ");
+      Serial.println(profile.host);
+      continue;
+    }
+    
+    // Every distinct host needs a connection pool slot
+    bool knownHost = false;
+    for (int i = 0; i < profileCount; i++) {
+      if (strcmp(profiles[i].host, profile.host) == 0) {
+        knownHost = true;
+        break;
+      }
+    }
+    if (!knownHost) {
+      if (hostCount >= MAX_POOLED_HOSTS) {
+        Serial.print("Skipping profile, too many distinct hosts: ");
+        Serial.println(profile.host);
+        continue;
+      }
+      hostCount++;
+    }
+    
+    Serial.print("Query profile: ");
+    Serial.print(profile.host);
+    Serial.print(" filter '");
+    Serial.print(profile.filter);
+    Serial.print("' weight ");
+    Serial.print(profile.weight);
+    Serial.print(profile.countsMode ? " (counts)" : " (per monitor)");
+    Serial.println(profile.pipelined ? " pipelined" : "");
+    profileCount++;
+  }
+  
+  return profileCount > 0;
+}
+
+struct ColorOrder {
+  const char* name;
+  neoPixelType type;
+};
+
+const ColorOrder COLOR_ORDERS[] = {
+  {"RGB", NEO_RGB}, {"RBG", NEO_RBG}, {"GRB", NEO_GRB}, {"GBR", NEO_GBR},
+  {"BRG", NEO_BRG}, {"BGR", NEO_BGR}, {"RGBW", NEO_RGBW}, {"GRBW", NEO_GRBW}
+};
+
+neoPixelType stripType = NEO_GRB;
+
+bool loadStripConfig() {
+  if (!LittleFS.exists(STRIP_CONFIG_FILE)) {
+    Serial.println("No strip config found, using defaults");
+    return false;
+  }
+  
+  File file = LittleFS.open(STRIP_CONFIG_FILE, "r");
+  if (!file) {
+    Serial.println("Failed to open strip config");
+    return false;
+  }
+  
+  StaticJsonDocument<256> doc;
+  DeserializationError error = deserializeJson(doc, file);
+  file.close();
+  
+  if (error) {
+    Serial.print("Failed to parse strip config: ");
+    Serial.println(error.c_str());
+    return false;
+  }
+  
+  int count = doc["count"] | LED_COUNT;
+  if (count < 1 || count > MAX_LED_COUNT) {
+    Serial.println("Strip length out of range, using defaults");
+    return false;
+  }
+  
+  const char* order = doc["order"] | "GRB";
+  bool orderFound = false;
+  for (const ColorOrder& entry : COLOR_ORDERS) {
+    if (strcasecmp(order, entry.name) == 0) {
+      stripType = entry.type;
+      orderFound = true;
+      break;
+    }
+  }
+  if (!orderFound) {
+    Serial.print("Unknown color order, using GRB: ");
+    Serial.println(order);
+  }
+  
+  // Pico W header GPIOs; 23-25 and 29 drive the CYW43 radio
+  int pin = doc["pin"] | LED_PIN;
+  if (pin < 0 || pin > 28 || (pin >= 23 && pin <= 25)) {
+    Serial.print("Invalid LED pin, using default: ");
+    Serial.println(pin);
+    pin = LED_PIN;
+  }
+  
+  stripLayout = strcasecmp(doc["layout"] | "ring", "bar") == 0 ? LAYOUT_BAR : LAYOUT_RING;
+  activeLedCount = constrain((int)(doc["active"] | ACTIVE_LED_COUNT), 1, count);
+  
+  strip.updateType(stripType + NEO_KHZ800);
+  strip.updateLength(count);
+  strip.setPin(pin);
+  
+  Serial.print("Strip: ");
+  Serial.print(count);
+  Serial.print(" LEDs, ");
+  Serial.print(order);
+  Serial.println(stripLayout == LAYOUT_BAR ? ", bar" : ", ring");
+  return true;
+}
+
+// ===== Last Status Persistence =====
+// Statuses are appended as small fixed-size records, only when the status
+// changes, so steady state costs no flash writes and LittleFS never has to
+// rewrite a whole file. The log restarts once it reaches STATUS_LOG_MAX_RECORDS.
+struct StatusRecord {
+  uint32_t timestamp;  // Unix time, 0 if the clock was not set yet
+  uint8_t status;      // Index into PERSISTED_STATUSES
+  uint8_t check;       // ~status, rejects a torn record
+  uint8_t reserved[2];
+};
+
+const char* const PERSISTED_STATUSES[] = {"ok", "warn", "alert", "no data"};
+const int PERSISTED_STATUS_COUNT = sizeof(PERSISTED_STATUSES) / sizeof(PERSISTED_STATUSES[0]);
+int persistedStatus = -1;  // Index of the last record written, -1 if none
+
+const char* loadLastStatus() {
+  if (!LittleFS.exists(STATUS_LOG_FILE)) {
+    Serial.println("No saved status found");
+    return nullptr;
+  }
+  
+  File file = LittleFS.open(STATUS_LOG_FILE, "r");
+  if (!file) return nullptr;
+  
+  // Walk back from the newest record, skipping any torn by a power cut
+  StatusRecord record;
+  long records = file.size() / sizeof(StatusRecord);
+  for (long i = records - 1; i >= 0; i--) {
+    file.seek(i * sizeof(StatusRecord));
+    if (file.read((uint8_t*)&record, sizeof(record)) == sizeof(record) &&
+        record.status < PERSISTED_STATUS_COUNT && record.check == (uint8_t)~record.status) {
+      file.close();
+      persistedStatus = record.status;
+      Serial.print("Restored last status: ");
+      Serial.print(PERSISTED_STATUSES[record.status]);
+      Serial.print(" (saved at ");
+      Serial.print(record.timestamp);
+      Serial.println(")");
+      return PERSISTED_STATUSES[record.status];
+    }
+  }
+  
+  file.close();
+  return nullptr;
+}
+
+void persistStatus(const char* status) {
+  int index = -1;
+  for (int i = 0; i < PERSISTED_STATUS_COUNT; i++) {
+    if (strcmp(status, PERSISTED_STATUSES[i]) == 0) {
+      index = i;
+      break;
+    }
+  }
+  if (index < 0 || index == persistedStatus) return;
+  
+  time_t now = time(nullptr);
+  StatusRecord record = {};
+  record.timestamp = now > 1600000000 ? (uint32_t)now : 0;
+  record.status = index;
+  record.check = ~index;
+  
+  File file = LittleFS.open(STATUS_LOG_FILE, "a");
+  if (file && file.size() >= STATUS_LOG_MAX_RECORDS * sizeof(StatusRecord)) {
+    file.close();
+    file = LittleFS.open(STATUS_LOG_FILE, "w");
+  }
+  if (!file) {
+    Serial.println("Failed to open status log");
+    return;
+  }
+  
+  if (file.write((const uint8_t*)&record, sizeof(record)) == sizeof(record)) {
+    persistedStatus = index;
+  }
+  file.close();
+}
+
 // ===== Boot Loop Detection =====
 bool loadBootCount(int& count) {
   if (!LittleFS.exists(BOOT_COUNT_FILE)) {
@@ -194,15 +507,20 @@ void checkBootLoop() {
 }
 
 // ===== Access Point Setup =====
-void startAccessPoint() {
-  Serial.println("\nStarting Access Point mode...");
-  
+// Bring up the setup network only; also used to restore it after a failed test-join
+void startSoftAP() {
   WiFi.mode(WIFI_AP);
   WiFi.softAP(AP_SSID, AP_PASSWORD);
   
   IPAddress apIP(192, 168, 4, 1);
   IPAddress netmask(255, 255, 255, 0);
   WiFi.softAPConfig(apIP, apIP, netmask);
+}
+
+void startAccessPoint() {
+  Serial.println("\nStarting Access Point mode...");
+  
+  startSoftAP();
   
   Serial.print("Access Point started: ");
   Serial.println(AP_SSID);
@@ -211,13 +529,21 @@ void startAccessPoint() {
   
   inAPMode = true;
   
-  // Set up web server routes
-  server.on("/", HTTP_GET, handleRoot);
-  server.on("/configure", HTTP_POST, handleConfigure);
-  server.onNotFound(handleNotFound);
+  // Any restored status is no longer meaningful once the tower needs setup
+  statusStale = false;
+  setLEDStatus("ap mode");
   
-  server.begin();
-  Serial.println("Web server started on port 80");
+  // AP mode can be entered more than once per boot, set up the routes only the first time
+  if (!webServerStarted) {
+    server.on("/", HTTP_GET, handleRoot);
+    server.on("/configure", HTTP_POST, handleConfigure);
+    server.on("/status", HTTP_GET, handleStatus);
+    server.onNotFound(handleNotFound);
+    
+    server.begin();
+    webServerStarted = true;
+    Serial.println("Web server started on port 80");
+  }
 }
 
 // ===== Web Server Handlers =====
@@ -369,7 +695,7 @@ void handleRoot() {
         </div>
         
         <div id="success" class="success">
-            ✓ Settings saved! Device will restart and attempt to connect.
+            <span id="successMsg"></span>
         </div>
         <div id="error" class="error">
             ✗ Error: <span id="errorMsg"></span>
@@ -393,7 +719,7 @@ void handleRoot() {
                 1. Enter your WiFi network name<br>
                 2. Enter your WiFi password<br>
                 3. Click 'Save & Connect'<br>
-                4. Device will restart and connect
+                4. Device tests the network, then switches over
             </div>
         </form>
     </div>
@@ -424,9 +750,9 @@ void handleRoot() {
                 });
                 
                 if (response.ok) {
-                    showSuccess();
+                    showSuccess('Testing connection to ' + ssid + '... The MoniTower-Setup network may drop while it tries; reconnect to it if it comes back.');
                     document.getElementById('wifiForm').style.display = 'none';
-                    setTimeout(() => location.reload(), 5000);
+                    pollStatus();
                 } else {
                     const error = await response.text();
                     showError(error || 'Failed to save settings');
@@ -436,8 +762,37 @@ void handleRoot() {
             }
         });
         
-        function showSuccess() {
+        // Poll the test-join result. The setup network drops during the join
+        // and only comes back if it fails, so a long silence means success.
+        let unreachableSince = 0;
+        async function pollStatus() {
+            try {
+                const response = await fetch('/status');
+                const status = await response.json();
+                
+                if (status.state === 'connected') {
+                    showSuccess('✓ Connected! IP address ' + status.ip + '. MoniTower is switching to your network.');
+                    return;
+                }
+                if (status.state === 'failed') {
+                    showError('Could not join the network. Check the name and password and try again.');
+                    document.getElementById('wifiForm').style.display = 'block';
+                    return;
+                }
+                unreachableSince = 0;
+            } catch (err) {
+                // Setup network down while the radio joins, keep polling
+                if (!unreachableSince) unreachableSince = Date.now();
+                if (Date.now() - unreachableSince > 30000) {
+                    showSuccess('MoniTower-Setup has not come back, so MoniTower most likely joined your network. If it reappears, reconnect to it to try again.');
+                }
+            }
+            setTimeout(pollStatus, 1000);
+        }
+        
+        function showSuccess(msg) {
             document.getElementById('success').style.display = 'block';
+            document.getElementById('successMsg').textContent = msg;
             document.getElementById('error').style.display = 'none';
         }
         
@@ -480,14 +835,50 @@ void handleConfigure() {
   // Handle null password for open networks
   const char* pwd = (password && strlen(password) > 0) ? password : "";
   
-  if (saveCredentials(ssid, pwd)) {
-    server.send(200, "text/plain", "OK");
-    // Schedule restart after response is sent
-    delay(100);
-    watchdog_reboot(0, 0, 100);
-  } else {
-    server.send(500, "text/plain", "Failed to save credentials");
+  if (strlen(ssid) >= sizeof(pendingCredentials.ssid) || strlen(pwd) >= sizeof(pendingCredentials.password)) {
+    server.send(400, "text/plain", "SSID or password too long");
+    return;
+  }
+  
+  strlcpy(pendingCredentials.ssid, ssid, sizeof(pendingCredentials.ssid));
+  strlcpy(pendingCredentials.password, pwd, sizeof(pendingCredentials.password));
+  
+  // Test-join the network; credentials are only saved once it connects (see
+  // updateProvisioning). arduino-pico drives a single CYW43 interface and
+  // joins as a plain station here, so the soft AP drops until the result is
+  // known - the setup page keeps polling and picks up again when it returns.
+  Serial.print("Testing WiFi credentials for: ");
+  Serial.println(pendingCredentials.ssid);
+  WiFi.mode(WIFI_AP_STA);
+  WiFi.begin(pendingCredentials.ssid, pendingCredentials.password);
+  provisionState = PROVISION_TESTING;
+  provisionStartTime = millis();
+  
+  server.send(202, "text/plain", "Testing");
+}
+
+void handleStatus() {
+  StaticJsonDocument<128> doc;
+  
+  switch (provisionState) {
+    case PROVISION_TESTING:
+      doc["state"] = "testing";
+      break;
+    case PROVISION_CONNECTED:
+      doc["state"] = "connected";
+      doc["ip"] = WiFi.localIP().toString();
+      break;
+    case PROVISION_FAILED:
+      doc["state"] = "failed";
+      break;
+    default:
+      doc["state"] = "idle";
+      break;
   }
+  
+  String json;
+  serializeJson(doc, json);
+  server.send(200, "application/json", json);
 }
 
 void handleNotFound() {
@@ -513,6 +904,15 @@ bool connectToWiFi() {
   return true;
 }
 
+// Common work once the station link is up, whichever path brought it up
+void onWiFiConnected() {
+  credentialsVerified = true;
+  Serial.print("IP address: ");
+  Serial.println(WiFi.localIP());
+  NTP.begin("pool.ntp.org");  // Timestamps for the status log
+  resetBootCount();  // Clear boot counter on successful connection
+}
+
 bool waitForWiFiConnection() {
   if (!wifiConnectAttempted) return false;
   
@@ -521,17 +921,22 @@ bool waitForWiFiConnection() {
   // Check if connected
   if (WiFi.status() == WL_CONNECTED) {
     Serial.println("\nWiFi connected!");
-    Serial.print("IP address: ");
-    Serial.println(WiFi.localIP());
     wifiConnectAttempted = false;
-    resetBootCount();  // Clear boot counter on successful connection
+    onWiFiConnected();
     return true;
   }
   
   // If timeout reached, connection failed
   if (elapsed >= WIFI_CONNECT_TIMEOUT) {
+    if (credentialsVerified) {
+      // These credentials have already worked this boot, the network is just slow to come back
+      Serial.println("\nWiFi rejoin timed out, retrying");
+      connectToWiFi();
+      return false;
+    }
     Serial.println("\nFailed to connect to WiFi - timeout");
     Serial.println("Wiping credentials and entering AP mode");
+    wifiConnectAttempted = false;
     deleteCredentials();
     startAccessPoint();
     return false;
@@ -545,8 +950,65 @@ bool waitForWiFiConnection() {
   return false;
 }
 
+// Leave the failed network and bring the setup network back so the user can retry
+void failProvisioning() {
+  WiFi.disconnect();
+  startSoftAP();
+  provisionState = PROVISION_FAILED;
+}
+
+void updateProvisioning() {
+  unsigned long elapsed = millis() - provisionStartTime;
+  
+  if (provisionState == PROVISION_TESTING) {
+    if (WiFi.status() == WL_CONNECTED) {
+      Serial.print("\nTest join succeeded, IP address: ");
+      Serial.println(WiFi.localIP());
+      if (saveCredentials(pendingCredentials.ssid, pendingCredentials.password)) {
+        provisionState = PROVISION_CONNECTED;
+        provisionStartTime = millis();
+      } else {
+        failProvisioning();
+      }
+    } else if (elapsed >= WIFI_CONNECT_TIMEOUT) {
+      Serial.println("\nTest join failed - timeout, restoring the portal");
+      failProvisioning();
+    }
+  } else if (provisionState == PROVISION_CONNECTED && elapsed >= PROVISION_HANDOFF_DELAY) {
+    // The browser has had time to read the result, hand over to station mode
+    Serial.println("Closing access point, continuing in station mode");
+    WiFi.softAPdisconnect();
+    inAPMode = false;
+    provisionState = PROVISION_IDLE;
+    
+    if (WiFi.status() == WL_CONNECTED) {
+      onWiFiConnected();
+      setLEDStatus("ok");
+    } else {
+      credentialsVerified = true;  // Proven by the test-join, retry rather than wipe if the rejoin is slow
+      connectToWiFi();  // Station link dropped with the AP, rejoin with the saved credentials
+    }
+  }
+}
+
 
 // ===== LED Functions =====
+// Picked once the strip config is loaded (see lib/ChaseRender)
+RenderKernel renderKernel = renderChaseGeneric;
+
+// Ring layouts wrap around, bar layouts bounce between the two ends
+int animationPeriod() {
+  if (stripLayout == LAYOUT_RING) return strip.numPixels();
+  return max(1, 2 * (strip.numPixels() - activeLedCount));
+}
+
+uint16_t chaseHead() {
+  int position = animationIndex % animationPeriod();
+  if (stripLayout == LAYOUT_RING) return position;
+  int span = strip.numPixels() - activeLedCount;
+  return position <= span ? position : 2 * span - position;
+}
+
 void setLEDStatus(const char* status) {
   strlcpy(currentStatus, status, sizeof(currentStatus));  // Save status for animation updates
   uint32_t fullColor;
@@ -576,98 +1038,347 @@ void setLEDStatus(const char* status) {
   
   uint32_t dimmedColor = strip.Color(r, g, b);
   
-  // Animate the LEDs
-  for (int i = 0; i < strip.numPixels(); i++) {
-    int distance = (i - animationIndex + strip.numPixels()) % strip.numPixels();
-    
-    if (distance < ACTIVE_LED_COUNT) {
-      strip.setPixelColor(i, fullColor);
-    } else {
-      strip.setPixelColor(i, dimmedColor);
-    }
+  // Stale variant: half-brightness head on a slower chase
+  if (statusStale) {
+    fullColor = (fullColor >> 1) & 0x7F7F7F;
   }
   
+  // Animate the LEDs
+  if (!stripReady) return;
+  renderKernel(strip.getPixels(), strip.numPixels(), stripType, chaseHead(), activeLedCount,
+               fullColor, dimmedColor);
   strip.show();
 }
 
 void updateAnimation() {
   unsigned long currentTime = millis();
-  if (currentTime - lastAnimationTime >= ANIMATION_DELAY) {
+  unsigned long frameDelay = statusStale ? STALE_ANIMATION_DELAY : ANIMATION_DELAY;
+  if (currentTime - lastAnimationTime >= frameDelay) {
     lastAnimationTime = currentTime;
-    animationIndex = (animationIndex + 1) % strip.numPixels();
+    animationIndex = (animationIndex + 1) % animationPeriod();
     // Redraw the LEDs with the updated animation index
     setLEDStatus(currentStatus);
   }
 }
 
+// A fresh result replaces any stale status restored at boot
+void reportStatus(const char* status) {
+  statusStale = false;
+  persistStatus(status);
+  setLEDStatus(status);
+}
+
 // ===== Datadog Monitor Check =====
-void checkMonitorStatus() {
-  if (!WiFi.isConnected()) {
-    return;
+HttpClient* getPooledClient(const char* host) {
+  for (int i = 0; i < pooledHostCount; i++) {
+    if (strcmp(connectionPool[i].host, host) == 0) {
+      return connectionPool[i].http;
+    }
   }
   
-  if (!httpClient) {
-    httpClient = new HttpClient(wifiClient, DATADOG_HOST, DATADOG_PORT);
-    httpClient->setHttpResponseTimeout(5000);  // 5 second timeout instead of 30
-    httpClient->setHttpWaitForDataDelay(50);   // Check more frequently
+  if (pooledHostCount >= MAX_POOLED_HOSTS) {
+    Serial.print("Connection pool full, cannot reach ");
+    Serial.println(host);
+    return nullptr;
   }
   
-  String path = "/api/v1/monitor?api_key=" + String(DATADOG_API_KEY) + 
-                "&application_key=" + String(DATADOG_APP_KEY);
-  
-  Serial.println("Querying Datadog monitor status...");
-  
-  int err = httpClient->get(path);
+  PooledConnection& conn = connectionPool[pooledHostCount++];
+  strlcpy(conn.host, host, sizeof(conn.host));
+  conn.client.setInsecure();
+  conn.http = new HttpClient(conn.client, conn.host, DATADOG_PORT);
+  conn.http->setHttpResponseTimeout(5000);
+  conn.http->setHttpWaitForDataDelay(50);
+  conn.http->setTimeout(JSON_STREAM_TIMEOUT);
+  conn.http->connectionKeepAlive();  // Reuse the TLS session across profiles and polls
+  return conn.http;
+}
+
+void appendUrlEncoded(String& out, const char* text) {
+  static const char hex[] = "0123456789ABCDEF";
+  for (const char* p = text; *p; p++) {
+    if (isalnum((unsigned char)*p) || *p == '-' || *p == '_' || *p == '.' || *p == '~') {
+      out += *p;
+    } else {
+      out += '%';
+      out += hex[(uint8_t)*p >> 4];
+      out += hex[(uint8_t)*p & 0x0F];
+    }
+  }
+}
+
+// Send a GET and position the connection at the start of the body.
+// Returns the body stream (inflating if gzipped), or nullptr on failure
+// with statusCode set to the HTTP status, or 0 if the request never got one.
+Stream* openResponseBody(HttpClient* http, const String& path, int& statusCode) {
+  statusCode = 0;
+  
+  // Responses compress ~10x, so ask for gzip to save WiFi airtime
+  http->beginRequest();
+  int err = http->get(path);
   if (err != 0) {
     Serial.print("Request error: ");
     Serial.println(err);
-    setLEDStatus("no data");
-    return;
+    http->stop();  // Force a fresh connection next time
+    return nullptr;
   }
+  http->sendHeader("Accept-Encoding", "gzip");
+  http->endRequest();
   
-  int statusCode = httpClient->responseStatusCode();
-  String response = httpClient->responseBody();
-  
+  statusCode = http->responseStatusCode();
   Serial.print("Status Code: ");
   Serial.println(statusCode);
   
-  if (statusCode == 200) {
-    StaticJsonDocument<2048> doc;
-    DeserializationError error = deserializeJson(doc, response);
-    
-    if (!error) {
-      Serial.println("Monitor Status Report:");
-      JsonArray monitors = doc.as<JsonArray>();
-      const char* overallStatus = "ok";
-      
-      for (JsonObject monitor : monitors) {
-        const char* monitorStatus = monitor["overall_state"].as<const char*>();
-        Serial.print("Monitor: ");
-        Serial.print(monitor["name"].as<const char*>());
-        Serial.print(" - Status: ");
-        Serial.println(monitorStatus);
-        
-        if (strcmp(monitorStatus, "alert") == 0) {
-          overallStatus = "alert";
-        } else if (strcmp(monitorStatus, "warn") == 0 && strcmp(overallStatus, "alert") != 0) {
-          overallStatus = "warn";
-        }
+  if (statusCode != 200) {
+    http->stop();
+    return nullptr;
+  }
+  
+  bool gzipped = false;
+  while (http->headerAvailable()) {
+    String name = http->readHeaderName();
+    String value = http->readHeaderValue();
+    if (name.equalsIgnoreCase("Content-Encoding") && value.indexOf("gzip") >= 0) {
+      gzipped = true;
+    }
+  }
+  
+  if (gzipped) {
+    return &gzipBody.begin(*http);
+  }
+  return http;
+}
+
+// Returns false if the body was unusable and the connection was dropped
+bool finishResponseBody(HttpClient* http, Stream* body) {
+  if (body == &gzipBody) {
+    Serial.print("Body: ");
+    Serial.print(gzipBody.compressedBytes());
+    Serial.print(" bytes on the wire, ");
+    Serial.print(gzipBody.inflatedBytes());
+    Serial.println(" bytes inflated");
+    if (gzipBody.failed()) {
+      http->stop();
+      return false;
+    }
+  }
+  
+  // Swallow the tail of the body so the next request on this connection starts clean
+  unsigned long lastData = millis();
+  while (!http->endOfBodyReached() && millis() - lastData < 100) {
+    if (http->read() >= 0) {
+      lastData = millis();
+    }
+  }
+  
+  // Unread body bytes would be taken for the next response, so don't reuse the connection
+  if (!http->endOfBodyReached()) {
+    http->stop();
+  }
+  return true;
+}
+
+// Counts mode: the monitor search API returns per-status facet counts for
+// the query, so the response stays a few hundred bytes whatever the org size.
+// Returns nullptr if the search API is not usable with this profile.
+const char* checkMonitorCounts(QueryProfile& profile, HttpClient* http) {
+  String path = "/api/v1/monitor/search?api_key=" + String(profile.apiKey) + 
+                "&application_key=" + String(profile.appKey) + "&per_page=1";
+  
+  // "env:prod,team:web" -> tag:"env:prod" tag:"team:web"
+  if (profile.filter[0] != '\0') {
+    String query;
+    char tags[sizeof(profile.filter)];
+    strlcpy(tags, profile.filter, sizeof(tags));
+    for (char* tag = strtok(tags, ","); tag; tag = strtok(nullptr, ",")) {
+      if (query.length() > 0) query += " ";
+      query += "tag:\"";
+      query += tag;
+      query += "\"";
+    }
+    path += "&query=";
+    appendUrlEncoded(path, query.c_str());
+  }
+  
+  Serial.print("Querying Datadog monitor counts on ");
+  Serial.println(profile.host);
+  
+  int statusCode;
+  Stream* body = openResponseBody(http, path, statusCode);
+  if (!body) {
+    // Only an unsupported endpoint or query means counts will never work;
+    // rate limiting (429) and key errors (401/403) would hit the listing too
+    if (statusCode == 400 || statusCode == 404) {
+      Serial.println("Monitor search unavailable, switching profile to full listing");
+      profile.countsMode = false;
+    }
+    return nullptr;
+  }
+  
+  StaticJsonDocument<64> filter;
+  filter["counts"]["status"] = true;
+  
+  StaticJsonDocument<512> doc;
+  DeserializationError error = deserializeJson(doc, *body, DeserializationOption::Filter(filter));
+  if (!finishResponseBody(http, body)) {
+    return nullptr;
+  }
+  if (error) {
+    Serial.print("JSON parsing error: ");
+    Serial.println(error.c_str());
+    return nullptr;
+  }
+  
+  int counts[4] = {0, 0, 0, 0};
+  for (JsonObject facet : doc["counts"]["status"].as<JsonArray>()) {
+    const char* name = facet["name"] | "";
+    int count = facet["count"] | 0;
+    Serial.print("Monitors ");
+    Serial.print(name);
+    Serial.print(": ");
+    Serial.println(count);
+    tallyStatus(counts, name, count);
+  }
+  
+  return summarizeStatusCounts(counts);
+}
+
+// Core 0 side of pipelined mode: keep receiving (and inflating) blocks into
+// the pipe while core 1 parses, until the parser has what it needs
+const char* parseOnCore1(Stream& source) {
+  bodyPipe.reset();
+  pipelineParseRequested.store(true, std::memory_order_release);
+  
+  if (!bodyPipe.fillFrom(source, JSON_STREAM_TIMEOUT)) {
+    Serial.println("Timed out receiving monitor list");
+  }
+  while (pipelineParseRequested.load(std::memory_order_acquire)) {
+    delay(1);
+  }
+  return pipelineStatus.load(std::memory_order_acquire);
+}
+
+// Core 1 side of pipelined mode
+void runPipelinedParse() {
+  pipelineStatus.store(aggregateMonitorList(bodyPipe), std::memory_order_release);
+  // Finish before releasing core 0, or a late finish() could end the next transfer
+  bodyPipe.finish();
+  pipelineParseRequested.store(false, std::memory_order_release);
+}
+
+// Full listing: downloads every monitor definition. Used for profiles that opt in
+// with "per_monitor": true (each monitor is logged to Serial) and where monitor
+// search is unavailable.
+const char* checkMonitorList(QueryProfile& profile, HttpClient* http) {
+  String path = "/api/v1/monitor?api_key=" + String(profile.apiKey) + 
+                "&application_key=" + String(profile.appKey);
+  if (profile.filter[0] != '\0') {
+    path += "&monitor_tags=";
+    appendUrlEncoded(path, profile.filter);
+  }
+  
+  Serial.print("Querying Datadog monitor status on ");
+  Serial.println(profile.host);
+  
+  int statusCode;
+  Stream* body = openResponseBody(http, path, statusCode);
+  if (!body) {
+    return nullptr;
+  }
+  
+  unsigned long start = millis();
+  const char* status = profile.pipelined ? parseOnCore1(*body) : aggregateMonitorList(*body);
+  Serial.print("Monitor list processed in ");
+  Serial.print(millis() - start);
+  Serial.println(profile.pipelined ? " ms (pipelined)" : " ms");
+  
+  if (!finishResponseBody(http, body)) {
+    return nullptr;
+  }
+  return status;
+}
+
+// Returns nullptr when the poll got no result (request, HTTP or body
+// error), as opposed to Datadog reporting "no data"
+const char* checkMonitorStatus(QueryProfile& profile) {
+  HttpClient* http = getPooledClient(profile.host);
+  if (!http) {
+    return nullptr;
+  }
+  
+  if (profile.countsMode) {
+    const char* status = checkMonitorCounts(profile, http);
+    if (status || profile.countsMode) {
+      return status;
+    }
+    // Search unsupported, counts mode was just cleared: use the listing right away
+  }
+  return checkMonitorList(profile, http);
+}
+
+// Poll up to MAX_POLLS_PER_CYCLE profiles, picked by smooth weighted
+// round-robin, then merge every profile's last result into one status
+void pollMonitorProfiles() {
+  if (!WiFi.isConnected()) {
+    return;
+  }
+  
+  bool polled[MAX_PROFILES] = {false};
+  int polls = min(profileCount, MAX_POLLS_PER_CYCLE);
+  
+  for (int n = 0; n < polls; n++) {
+    int best = -1;
+    int remainingWeight = 0;
+    for (int i = 0; i < profileCount; i++) {
+      if (polled[i]) continue;
+      profiles[i].currentWeight += profiles[i].weight;
+      remainingWeight += profiles[i].weight;
+      if (best < 0 || profiles[i].currentWeight > profiles[best].currentWeight) {
+        best = i;
       }
-      
-      setLEDStatus(overallStatus);
+    }
+    
+    profiles[best].currentWeight -= remainingWeight;
+    polled[best] = true;
+    
+    // A timeout or dropped keep-alive socket keeps the last good result;
+    // only a profile that stays unreachable turns to "no data"
+    QueryProfile& profile = profiles[best];
+    const char* status = checkMonitorStatus(profile);
+    if (status) {
+      profile.status = status;
+      profile.failedPolls = 0;
+    } else if (++profile.failedPolls >= MAX_FAILED_POLLS) {
+      profile.status = "no data";
     } else {
-      Serial.print("JSON parsing error: ");
-      Serial.println(error.c_str());
-      setLEDStatus("no data");
+      Serial.print("Poll failed, keeping last status for ");
+      Serial.println(profile.host);
+    }
+  }
+  
+  const char* mergedStatus = nullptr;
+  for (int i = 0; i < profileCount; i++) {
+    if (statusSeverity(profiles[i].status) > statusSeverity(mergedStatus)) {
+      mergedStatus = profiles[i].status;
     }
   }
+  
+  // Nothing has answered yet, leave the restored status up
+  if (!mergedStatus) {
+    return;
+  }
+  
+  Serial.print("Merged status across ");
+  Serial.print(profileCount);
+  Serial.print(" profiles: ");
+  Serial.println(mergedStatus);
+  reportStatus(mergedStatus);
 }
 
 // ===== Datadog Monitor Check =====
 void checkMonitorStatusGoogle() {
   if (!WiFi.isConnected()) {
     Serial.println("WiFi not connected");
-    setLEDStatus("no data");
+    reportStatus("no data");
     return;
   }
   
@@ -695,7 +1406,7 @@ void checkMonitorStatusGoogle() {
   if (err != 0) {
     Serial.print("Connection failed with error: ");
     Serial.println(err);
-    setLEDStatus("no data");
+    reportStatus("no data");
     return;
   }
   
@@ -708,10 +1419,10 @@ void checkMonitorStatusGoogle() {
   
   if (statusCode == 200) {
       Serial.println("Google is reachable, setting status to OK");
-      setLEDStatus("ok");
+      reportStatus("ok");
     } else {
       Serial.println("Google is not reachable, setting status to ALERT");
-      setLEDStatus("alert");
+      reportStatus("alert");
     }
 }
 
@@ -735,13 +1446,27 @@ void setup() {
     Serial.println("File system mounted successfully");
   }
   
+  // Load Datadog query profiles
+  loadProfiles();
+  
   // Check for boot loop EARLY
   checkBootLoop();
   
   // Initialize LED strip
+  loadStripConfig();
+  renderKernel = selectRenderKernel(stripType, strip.numPixels());
   strip.begin();
   strip.show();
-  setLEDStatus("no data");
+  stripReady = true;
+  
+  // Show the last known status until the first poll completes
+  const char* lastStatus = loadLastStatus();
+  if (lastStatus) {
+    statusStale = true;
+    setLEDStatus(lastStatus);
+  } else {
+    setLEDStatus("no data");
+  }
   
   // Load stored credentials
   if (loadCredentials()) {
@@ -753,7 +1478,6 @@ void setup() {
   } else {
     // No credentials saved, start AP mode
     startAccessPoint();
-    setLEDStatus("ap mode");
   }
 }
 
@@ -763,16 +1487,21 @@ void loop() {
     server.handleClient();
   }
   
-  // Handle WiFi connection attempts
-  if (wifiConnectAttempted) {
+  // Handle test-joining newly submitted credentials
+  if (provisionState != PROVISION_IDLE) {
+    updateProvisioning();
+  }
+  
+  // Handle WiFi connection attempts (a provisioning test-join manages its own)
+  if (wifiConnectAttempted && provisionState == PROVISION_IDLE) {
     if (waitForWiFiConnection()) {
       // Connection successful
       inAPMode = false;
-      setLEDStatus("ok");
+      if (!statusStale) setLEDStatus("ok");
     } else if (WiFi.status() == WL_CONNECTED) {
       // Connection succeeded
       inAPMode = false;
-      setLEDStatus("ok");
+      if (!statusStale) setLEDStatus("ok");
     }
   }
   
@@ -781,9 +1510,15 @@ void loop() {
   // If connected, check monitor status periodically
   if (WiFi.status() == WL_CONNECTED && !inAPMode) {
     static unsigned long lastCheck = 0;
-    if (millis() - lastCheck > 30000) {  // Check every 30 seconds
+    static bool checkedOnce = false;
+    if (!checkedOnce || millis() - lastCheck > 30000) {  // Check on connect, then every 30 seconds
+      checkedOnce = true;
       lastCheck = millis();
-      checkMonitorStatusGoogle();  // Use dummy for now
+      if (profileCount > 0) {
+        pollMonitorProfiles();
+      } else {
+        checkMonitorStatusGoogle();  // No profiles configured, fall back to connectivity check
+      }
     }
   }
   
@@ -792,11 +1527,18 @@ void loop() {
 
 // ===== Core 1 - Animation Loop =====
 void setup1() {
-  // Core 1 setup (if needed)
+  // Keep animating while waiting on the pipe in pipelined mode
+  bodyPipe.onIdle(updateAnimation);
 }
 
 void loop1() {
   // Core 1 continuously updates animation without blocking
   updateAnimation();
+  
+  // Parse a monitor list that core 0 is receiving
+  if (pipelineParseRequested.load(std::memory_order_acquire)) {
+    runPipelinedParse();
+  }
+  
   delay(10);  // Small delay to prevent consuming too much CPU
 }
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+// Minimal Arduino API for building the project libraries on the host
+// (env:native). Only what lib/ uses is provided; Serial output is dropped
+// so it does not skew benchmark timings.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <chrono>
+#include <thread>
+
+inline unsigned long millis() {
+  using namespace std::chrono;
+  static const steady_clock::time_point start = steady_clock::now();
+  return duration_cast<milliseconds>(steady_clock::now() - start).count();
+}
+
+inline unsigned long micros() {
+  using namespace std::chrono;
+  static const steady_clock::time_point start = steady_clock::now();
+  return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+inline void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+inline void yield() {
+  std::this_thread::yield();
+}
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t) = 0;
+  template <typename T> size_t print(T) { return 0; }
+  template <typename T> size_t println(T) { return 0; }
+  size_t println() { return 0; }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long timeout) { _timeout = timeout; }
+
+  size_t readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+      int c = timedRead();
+      if (c < 0) break;
+      buffer[count++] = (char)c;
+    }
+    return count;
+  }
+  size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+
+  bool find(const char* target) { return findUntil(target, nullptr); }
+
+  // Same naive matcher as the Arduino core
+  bool findUntil(const char* target, const char* terminator) {
+    size_t targetLength = strlen(target);
+    size_t terminatorLength = terminator ? strlen(terminator) : 0;
+    size_t index = 0;
+    size_t terminatorIndex = 0;
+    int c;
+    while ((c = timedRead()) >= 0) {
+      if (c != target[index]) index = 0;
+      if (c == target[index] && ++index >= targetLength) return true;
+      if (terminatorLength) {
+        if (c == terminator[terminatorIndex]) {
+          if (++terminatorIndex >= terminatorLength) return false;
+        } else {
+          terminatorIndex = 0;
+        }
+      }
+    }
+    return false;
+  }
+
+protected:
+  int timedRead() {
+    unsigned long start = millis();
+    do {
+      int c = read();
+      if (c >= 0) return c;
+    } while (millis() - start < _timeout);
+    return -1;
+  }
+
+  unsigned long _timeout = 1000;
+};
+
+class HostSerial : public Stream {
+public:
+  void begin(unsigned long) {}
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  size_t write(uint8_t) override { return 1; }
+};
+
+static HostSerial Serial;
@@ -0,0 +1,108 @@
+#pragma once
+
+// Shared helpers for the host benchmarks: an in-memory Stream, file loading
+// and peak heap tracking. Include from exactly one file per test program.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <vector>
+#include <string>
+
+#ifndef BENCH_DATA_DIR
+#define BENCH_DATA_DIR "test/data"
+#endif
+
+// Replays a captured or sample body, optionally throttled to a link rate
+class MemoryStream : public Stream {
+public:
+  MemoryStream(const uint8_t* data, size_t length, unsigned long bytesPerSecond = 0)
+    : data(data), length(length), bytesPerSecond(bytesPerSecond), start(micros()) {}
+
+  int available() override { return allowed() - position; }
+  int read() override { return position < allowed() ? data[position++] : -1; }
+  int peek() override { return position < allowed() ? data[position] : -1; }
+  size_t write(uint8_t) override { return 0; }
+  size_t consumed() const { return position; }
+
+private:
+  size_t allowed() const {
+    if (!bytesPerSecond) return length;
+    unsigned long long arrived = (unsigned long long)(micros() - start) * bytesPerSecond / 1000000;
+    return arrived < length ? arrived : length;
+  }
+
+  const uint8_t* data;
+  size_t length;
+  size_t position = 0;
+  unsigned long bytesPerSecond;
+  unsigned long start;
+};
+
+inline std::vector<uint8_t> loadBenchFile(const char* name) {
+  std::string path = std::string(BENCH_DATA_DIR) + "/" + name;
+  std::vector<uint8_t> data;
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) return data;
+  uint8_t buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    data.insert(data.end(), buffer, buffer + n);
+  }
+  fclose(file);
+  return data;
+}
+
+// Peak heap tracking. glibc lets the program interpose malloc; elsewhere the
+// heap figures read as 0 and only the static buffer sizes are meaningful.
+#if defined(__GLIBC__)
+#include <malloc.h>
+#include <atomic>
+
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void __libc_free(void*);
+
+static std::atomic<long> benchHeapCurrent{0};
+static std::atomic<long> benchHeapPeak{0};
+
+static inline void benchHeapTrack(long delta) {
+  long now = benchHeapCurrent.fetch_add(delta) + delta;
+  long peak = benchHeapPeak.load();
+  while (now > peak && !benchHeapPeak.compare_exchange_weak(peak, now)) {}
+}
+
+extern "C" void* malloc(size_t size) {
+  void* p = __libc_malloc(size);
+  if (p) benchHeapTrack(malloc_usable_size(p));
+  return p;
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+  void* p = __libc_calloc(count, size);
+  if (p) benchHeapTrack(malloc_usable_size(p));
+  return p;
+}
+
+extern "C" void* realloc(void* old, size_t size) {
+  long before = old ? (long)malloc_usable_size(old) : 0;
+  void* p = __libc_realloc(old, size);
+  if (p) benchHeapTrack((long)malloc_usable_size(p) - before);
+  else if (size == 0) benchHeapTrack(-before);
+  return p;
+}
+
+extern "C" void free(void* p) {
+  if (p) benchHeapTrack(-(long)malloc_usable_size(p));
+  __libc_free(p);
+}
+
+// Heap growth above the level at the last reset
+inline void heapPeakReset() { benchHeapPeak.store(benchHeapCurrent.load()); }
+inline long heapPeakSinceReset(long baseline) { return benchHeapPeak.load() - baseline; }
+inline long heapCurrent() { return benchHeapCurrent.load(); }
+#else
+inline void heapPeakReset() {}
+inline long heapPeakSinceReset(long) { return 0; }
+inline long heapCurrent() { return 0; }
+#endif
@@ -0,0 +1,122 @@
+// Host benchmark: gzip monitor listing through InflateStream vs the
+// uncompressed body, on the synthetic payload in test/data.
+//
+//   pio test -e native -f test_bench_inflate -v
+
+#include <unity.h>
+#include <bench_support.h>
+#include <InflateStream.h>
+
+static const int ITERATIONS = 20;
+
+static InflateStream inflater;
+static std::vector<uint8_t> compressed;
+
+static uint32_t crc32(const std::vector<uint8_t>& data) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (uint8_t byte : data) {
+    crc ^= byte;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+  }
+  return ~crc;
+}
+
+static uint32_t trailerWord(int offsetFromEnd) {
+  const uint8_t* p = &compressed[compressed.size() - offsetFromEnd];
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Drain a body the way the JSON parser does, one byte at a time
+static volatile uint32_t sink;
+
+static size_t drain(Stream& body) {
+  size_t count = 0;
+  uint32_t sum = 0;
+  int c;
+  while ((c = body.read()) >= 0) {
+    sum += c;
+    count++;
+  }
+  sink = sum;
+  return count;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_inflate_matches_sample_payload() {
+  MemoryStream wire(compressed.data(), compressed.size());
+  std::vector<uint8_t> body;
+  inflater.begin(wire);
+  int c;
+  while ((c = inflater.read()) >= 0) body.push_back(c);
+
+  TEST_ASSERT_TRUE(inflater.finished());
+  TEST_ASSERT_EQUAL_UINT32(trailerWord(4), body.size());
+  TEST_ASSERT_EQUAL_HEX32(trailerWord(8), crc32(body));
+}
+
+void test_bench_gzip_vs_uncompressed() {
+  std::vector<uint8_t> body;
+  {
+    MemoryStream wire(compressed.data(), compressed.size());
+    inflater.begin(wire);
+    int c;
+    while ((c = inflater.read()) >= 0) body.push_back(c);
+  }
+
+  unsigned long plainBest = ~0UL, gzipBest = ~0UL;
+  unsigned long plainTotal = 0, gzipTotal = 0;
+  long plainHeap = 0, gzipHeap = 0;
+
+  for (int i = 0; i < ITERATIONS; i++) {
+    long baseline = heapCurrent();
+    heapPeakReset();
+    MemoryStream plainWire(body.data(), body.size());
+    unsigned long start = micros();
+    TEST_ASSERT_EQUAL(body.size(), drain(plainWire));
+    unsigned long elapsed = micros() - start;
+    plainBest = elapsed < plainBest ? elapsed : plainBest;
+    plainTotal += elapsed;
+    plainHeap = heapPeakSinceReset(baseline);
+
+    baseline = heapCurrent();
+    heapPeakReset();
+    MemoryStream gzipWire(compressed.data(), compressed.size());
+    start = micros();
+    TEST_ASSERT_EQUAL(body.size(), drain(inflater.begin(gzipWire)));
+    elapsed = micros() - start;
+    gzipBest = elapsed < gzipBest ? elapsed : gzipBest;
+    gzipTotal += elapsed;
+    gzipHeap = heapPeakSinceReset(baseline);
+  }
+
+  printf("\nSynthetic monitor listing, %d iterations\n", ITERATIONS);
+  printf("%-22s %12s %12s %12s %14s\n", "path", "wire bytes", "best us", "mean us", "peak RAM bytes");
+  printf("%-22s %12zu %12s %12s %13zu*\n", "responseBody() (old)", body.size(), "n/a", "n/a", body.size());
+  printf("%-22s %12zu %12lu %12lu %14ld\n", "uncompressed stream", body.size(),
+         plainBest, plainTotal / ITERATIONS, plainHeap);
+  printf("%-22s %12zu %12lu %12lu %14ld\n", "gzip + InflateStream", compressed.size(),
+         gzipBest, gzipTotal / ITERATIONS, (long)sizeof(InflateStream) + gzipHeap);
+  printf("Wire reduction %.1fx on this synthetic payload (real responses ~10x)\n",
+         (double)body.size() / compressed.size());
+  printf("Inflate cost %.1f ns per output byte on this host\n", 1000.0 * gzipBest / body.size());
+  printf("* Not measured: the old path buffered the whole body in a String, so this is\n"
+         "  a computed lower bound on its peak RAM (String growth overhead excluded).\n");
+}
+
+int main(int, char**) {
+  compressed = loadBenchFile("monitor_list.json.gz");
+
+  UNITY_BEGIN();
+  if (compressed.size() < 18) {
+    TEST_MESSAGE("Sample payload " BENCH_DATA_DIR "/monitor_list.json.gz not found");
+    TEST_FAIL();
+  } else {
+    RUN_TEST(test_inflate_matches_sample_payload);
+    RUN_TEST(test_bench_gzip_vs_uncompressed);
+  }
+  return UNITY_END();
+}
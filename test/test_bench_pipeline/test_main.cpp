@@ -0,0 +1,129 @@
+// Host benchmark: the synthetic monitor listing through aggregateMonitorList,
+// parsed serially vs pipelined through PipeStream with the parser on a
+// second thread (standing in for core 1), on the payload in test/data.
+//
+//   pio test -e native -f test_bench_pipeline -v
+
+#include <unity.h>
+#include <bench_support.h>
+#include <InflateStream.h>
+#include <PipeStream.h>
+#include <MonitorList.h>
+#include <atomic>
+#include <thread>
+
+static const int ITERATIONS = 5;
+static const unsigned long LINK_BYTES_PER_SECOND = 100000;  // Roughly what the Pico W sustains over TLS
+
+static InflateStream inflater;
+static PipeStream pipe;
+static std::vector<uint8_t> compressed;
+static std::vector<uint8_t> body;
+
+// Same split as parseOnCore1/runPipelinedParse: this thread receives into
+// the pipe while the parser thread consumes it
+static const char* parsePipelined(Stream& source) {
+  std::atomic<const char*> status{nullptr};
+  pipe.reset();
+  pipe.onIdle(yield);  // updateAnimation() on the device; here it lets the other thread run
+  std::thread parser([&status]() {
+    status.store(aggregateMonitorList(pipe), std::memory_order_release);
+    pipe.finish();
+  });
+  pipe.fillFrom(source, JSON_STREAM_TIMEOUT);
+  parser.join();
+  return status.load(std::memory_order_acquire);
+}
+
+struct Result {
+  unsigned long bestUs = ~0UL;
+  unsigned long totalUs = 0;
+  long heapPeak = 0;
+  const char* status = nullptr;
+};
+
+static Result run(bool gzip, bool pipelined, unsigned long bytesPerSecond) {
+  Result result;
+  for (int i = 0; i < ITERATIONS; i++) {
+    long baseline = heapCurrent();
+    heapPeakReset();
+
+    const std::vector<uint8_t>& wireData = gzip ? compressed : body;
+    MemoryStream wire(wireData.data(), wireData.size(), bytesPerSecond);
+    wire.setTimeout(JSON_STREAM_TIMEOUT);
+    Stream* source = &wire;
+    if (gzip) source = &inflater.begin(wire);
+
+    unsigned long start = micros();
+    result.status = pipelined ? parsePipelined(*source) : aggregateMonitorList(*source);
+    unsigned long elapsed = micros() - start;
+
+    result.bestUs = elapsed < result.bestUs ? elapsed : result.bestUs;
+    result.totalUs += elapsed;
+    long heap = heapPeakSinceReset(baseline);
+    result.heapPeak = heap > result.heapPeak ? heap : result.heapPeak;
+  }
+  return result;
+}
+
+static void report(const char* name, const Result& result, size_t buffers) {
+  printf("%-34s %10lu %10lu %10zu %10ld %8s\n", name, result.bestUs / 1000, result.totalUs / ITERATIONS / 1000,
+         buffers, result.heapPeak, result.status ? result.status : "(null)");
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_pipelined_matches_serial() {
+  Result serial = run(true, false, 0);
+  Result pipelined = run(true, true, 0);
+  TEST_ASSERT_EQUAL_STRING("alert", serial.status);
+  TEST_ASSERT_EQUAL_STRING(serial.status, pipelined.status);
+}
+
+void test_bench_serial_vs_pipelined() {
+  struct Case {
+    const char* name;
+    bool gzip;
+    bool pipelined;
+    unsigned long bytesPerSecond;
+  };
+  const Case cases[] = {
+    {"plain, serial", false, false, 0},
+    {"plain, pipelined", false, true, 0},
+    {"gzip, serial", true, false, 0},
+    {"gzip, pipelined", true, true, 0},
+    {"gzip @ 100 KB/s, serial", true, false, LINK_BYTES_PER_SECOND},
+    {"gzip @ 100 KB/s, pipelined", true, true, LINK_BYTES_PER_SECOND},
+  };
+
+  printf("\nSynthetic monitor listing (%zu bytes, %zu gzipped), %d iterations\n", body.size(), compressed.size(),
+         ITERATIONS);
+  printf("%-34s %10s %10s %10s %10s %8s\n", "path", "best ms", "mean ms", "buffers B", "heap B", "status");
+  for (const Case& c : cases) {
+    Result result = run(c.gzip, c.pipelined, c.bytesPerSecond);
+    TEST_ASSERT_EQUAL_STRING("alert", result.status);
+    size_t buffers = (c.gzip ? sizeof(InflateStream) : 0) + (c.pipelined ? sizeof(PipeStream) : 0);
+    report(c.name, result, buffers);
+  }
+  printf("Heap includes the parser thread's bookkeeping in pipelined runs; core 1 has its own stack on the device.\n");
+}
+
+int main(int, char**) {
+  compressed = loadBenchFile("monitor_list.json.gz");
+
+  UNITY_BEGIN();
+  if (compressed.size() < 18) {
+    TEST_MESSAGE("Sample payload " BENCH_DATA_DIR "/monitor_list.json.gz not found");
+    TEST_FAIL();
+  } else {
+    MemoryStream wire(compressed.data(), compressed.size());
+    inflater.begin(wire);
+    int c;
+    while ((c = inflater.read()) >= 0) body.push_back(c);
+
+    RUN_TEST(test_pipelined_matches_serial);
+    RUN_TEST(test_bench_serial_vs_pipelined);
+  }
+  return UNITY_END();
+}
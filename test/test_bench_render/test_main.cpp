@@ -0,0 +1,112 @@
+// Benchmark: chase render time per frame for 16 to 300 LEDs, specialized
+// kernels vs the generic per-pixel kernel. On the Pico W the sweep also
+// times strip.show() on LED_PIN, giving render-plus-show per frame.
+//
+//   pio test -e native -f test_bench_render -v     (render only)
+//   pio test -e rpipicow -f test_bench_render -v   (render + show, on device)
+
+#include <Arduino.h>
+#include <unity.h>
+#include <ChaseRender.h>
+#include <stdio.h>
+
+#ifdef ARDUINO
+#include <Adafruit_NeoPixel.h>
+#define LED_PIN 8
+Adafruit_NeoPixel strip(16, LED_PIN, NEO_GRB + NEO_KHZ800);
+#define report(...) Serial.printf(__VA_ARGS__)
+#else
+#define report(...) printf(__VA_ARGS__)
+#endif
+
+static const uint16_t LENGTHS[] = {16, 30, 60, 100, 144, 200, 300};
+static const uint16_t MAX_LENGTH = 300;
+static const uint16_t ACTIVE = 3;
+static const uint32_t FULL = 0xFF0000;
+static const uint32_t DIMMED = 0x1E0000;
+
+static uint8_t pixels[MAX_LENGTH * 4];
+static uint8_t reference[MAX_LENGTH * 4];
+
+// Mean microseconds per frame, moving the head every frame like the animation
+static float timeKernel(RenderKernel kernel, uint16_t count, uint8_t order, int frames) {
+  unsigned long start = micros();
+  for (int frame = 0; frame < frames; frame++) {
+    kernel(pixels, count, order, frame % count, ACTIVE, FULL, DIMMED);
+  }
+  return (float)(micros() - start) / frames;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_specialized_kernels_match_generic() {
+  const uint8_t orders[] = {CHASE_ORDER_GRB, CHASE_ORDER_RGB, CHASE_ORDER_GRBW};
+  for (uint8_t order : orders) {
+    size_t bytesPerPixel = order == CHASE_ORDER_GRBW ? 4 : 3;
+    for (uint16_t count : LENGTHS) {
+      RenderKernel kernel = selectRenderKernel(order, count);
+      TEST_ASSERT_TRUE(kernel != renderChaseGeneric);
+      const uint16_t heads[] = {0, (uint16_t)(count / 2), (uint16_t)(count - 1)};
+      for (uint16_t head : heads) {
+        renderChaseGeneric(reference, count, order, head, ACTIVE, FULL, DIMMED);
+        kernel(pixels, count, order, head, ACTIVE, FULL, DIMMED);
+        TEST_ASSERT_EQUAL_MEMORY(reference, pixels, count * bytesPerPixel);
+      }
+    }
+  }
+}
+
+void test_bench_render_sweep() {
+  const int frames = 2000;
+
+  report("\n%6s %14s %14s %8s", "LEDs", "generic us", "GRB kernel us", "speedup");
+#ifdef ARDUINO
+  report(" %10s %16s", "show us", "render+show us");
+#endif
+  report("\n");
+
+  for (uint16_t count : LENGTHS) {
+    float generic = timeKernel(renderChaseGeneric, count, CHASE_ORDER_GRB, frames);
+    float specialized = timeKernel(selectRenderKernel(CHASE_ORDER_GRB, count), count, CHASE_ORDER_GRB, frames);
+    report("%6u %14.2f %14.2f %7.1fx", count, generic, specialized, generic / specialized);
+
+#ifdef ARDUINO
+    // show() time depends only on length: 24 bits at 800 kHz per LED plus latch
+    strip.updateLength(count);
+    const int shows = 20;
+    unsigned long start = micros();
+    for (int i = 0; i < shows; i++) {
+      selectRenderKernel(CHASE_ORDER_GRB, count)(strip.getPixels(), count, CHASE_ORDER_GRB, i % count,
+                                                 ACTIVE, FULL, DIMMED);
+      strip.show();
+    }
+    float frame = (float)(micros() - start) / shows;
+    report(" %10.1f %16.1f", frame - specialized, frame);
+#endif
+    report("\n");
+  }
+}
+
+static int runBenchmarks() {
+  UNITY_BEGIN();
+  RUN_TEST(test_specialized_kernels_match_generic);
+  RUN_TEST(test_bench_render_sweep);
+  return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+  delay(2000);  // Give the serial monitor time to attach
+  strip.begin();
+  runBenchmarks();
+  strip.clear();
+  strip.show();
+}
+
+void loop() {}
+#else
+int main(int, char**) {
+  return runBenchmarks();
+}
+#endif